@@ -4,6 +4,13 @@
 #include <string>
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <new>
+#include <cstdlib>
 
 #define kExpected(func, value)      { if ((func) != (value)) { fprintf(stderr, "Error: %s\n", #func); } }
 #define kNotExpected(func, value)   { if ((func) == (value)) { fprintf(stderr, "Error: %s\n", #func); } }
@@ -28,9 +35,160 @@ Now() {
     return high_resolution_clock::now();
 }
 
+//-------------------------------------
+// Heap accounting for the memory benchmark
+//-------------------------------------
+#if defined(_MSC_VER)
+    #define kNoInline   __declspec(noinline)
+#else
+    #define kNoInline   __attribute__((noinline))
+#endif
+
+static std::atomic<size_t> gNumAllocations {};
+static std::atomic<size_t> gAllocatedBytes {};
+
+void *
+operator new(size_t size) {
+    gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = malloc(size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+// Not inlined: GCC warns (-Wmismatched-new-delete) if it sees free() on memory returned by operator new
+kNoInline void
+operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+kNoInline void
+operator delete(void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+// The arrays too, so they are counted even if the runtime does not forward them to operator new
+void *
+operator new[](size_t size) {
+    return operator new(size);
+}
+
+kNoInline void
+operator delete[](void *ptr) noexcept {
+    free(ptr);
+}
+
+kNoInline void
+operator delete[](void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+// Heap used since its creation
+struct HeapCounter {
+    size_t  GetAllocations() const  { return gNumAllocations - allocations; }
+    size_t  GetBytes() const        { return gAllocatedBytes - bytes;       }
+
+    size_t  allocations = gNumAllocations;
+    size_t  bytes       = gAllocatedBytes;
+};
+
 //-------------------------------------
 using namespace MindShake;
 
+// Layout used by the Delegate before the compact storage (for comparison)
+//-------------------------------------
+struct LegacyDelegateLayout {
+    virtual ~LegacyDelegateLayout() = default;
+
+    std::vector<void *>     wrappers;
+    std::vector<size_t>     toRemove;
+    std::atomic_bool        isRunning {};
+};
+
+//-------------------------------------
+// Cross-thread delivery benchmark
+//-------------------------------------
+static inline int64_t
+NowNs() {
+    return duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch()).count();
+}
+
+// What the listeners were doing before DelegateExecutor: one std::function per listener and call
+struct FunctionQueue {
+    void Post(std::function<void()> &&function) {
+        std::lock_guard<std::mutex> lock(mutex);
+        functions.emplace_back(std::move(function));
+    }
+
+    size_t Dispatch() {
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.swap(functions);
+        }
+        for (auto &function : pending)
+            function();
+
+        return pending.size();
+    }
+
+    std::mutex                          mutex;
+    std::vector<std::function<void()>>  functions;
+};
+
+struct Receiver {
+    void Receive(int64_t sent) {
+        latency += NowNs() - sent;
+        received.fetch_add(1, std::memory_order_release);
+    }
+
+    void WaitFor(size_t count) const {
+        while (received.load(std::memory_order_acquire) < count)
+            std::this_thread::yield();
+    }
+
+    std::atomic<size_t> received {};
+    int64_t             latency  {};
+};
+
+// Runs 'mailbox.Dispatch()' in its own thread (like a render thread loop) while 'delegate' is called from this one
+template <typename Mailbox>
+void
+BenchmarkCrossThread(const char *name, Delegate<void(int64_t)> &delegate, Mailbox &mailbox, Receiver &receiver, size_t numListeners) {
+    constexpr const size_t numPings  = 10000;
+    constexpr const size_t numEvents = 100000;
+
+    std::atomic_bool    isRunning {true};
+    std::thread         thread([&]() {
+        while (isRunning) {
+            if (mailbox.Dispatch() == 0)
+                std::this_thread::yield();
+        }
+    });
+
+    // Latency: one event at a time
+    for (size_t i=1; i<=numPings; ++i) {
+        delegate(NowNs());
+        receiver.WaitFor(i * numListeners);
+    }
+    int64_t latency = receiver.latency;
+
+    // Throughput: a burst of events
+    size_t expected   = receiver.received + numEvents * numListeners;
+    auto   timeStamp  = Now();
+    for (size_t i=0; i<numEvents; ++i)
+        delegate(NowNs());
+    receiver.WaitFor(expected);
+    auto   time       = Now() - timeStamp;
+
+    isRunning = false;
+    thread.join();
+
+    printf("%-22s latency:    %d ns\n", name, int(latency / int64_t(numPings * numListeners)));
+    printf("%-22s throughput: %d events/s\n", name, int(double(numEvents) / duration_cast<duration<double>>(time).count()));
+}
+
 //-------------------------------------
 void
 func() {
@@ -60,6 +218,28 @@ protected:
     std::string name;
 };
 
+// Counts the living copies (to know when a function has been released)
+//-------------------------------------
+struct Tracker {
+    Tracker()                   { ++alive; }
+    Tracker(const Tracker &)    { ++alive; }
+    ~Tracker()                  { --alive; }
+
+    static int alive;
+};
+
+int Tracker::alive = 0;
+
+//-------------------------------------
+struct OrderMessage : DelegateExecutor::Message {
+    OrderMessage(std::vector<int> &order, int value) : order(order), value(value) {}
+
+    void Run() override         { order.emplace_back(value); }
+
+    std::vector<int>    &order;
+    int                 value;
+};
+
 //-------------------------------------
 int
 main(int argc, char *argv[]) {
@@ -158,6 +338,149 @@ main(int argc, char *argv[]) {
     printf("\nCalling delegate:\n");
     delegate();
 
+    // Storage: empty -> one function -> List -> one function -> empty
+    {
+        Delegate<void(int &)> compact;
+        int calls = 0;
+
+        kExpected(compact.GetNumDelegates(), 0);
+        compact(calls);
+        kExpected(calls, 0);
+
+        auto incId = compact.Add(inc);
+        kExpected(compact.GetNumDelegates(), 1);
+        compact(calls);
+        kExpected(calls, 1);
+
+        auto lambdaId = compact.Add([](int &var) { var += 10; });
+        kExpected(compact.GetNumDelegates(), 2);
+        compact(calls);
+        kExpected(calls, 12);
+
+        kCheckTrue(compact.RemoveById(incId));
+        kExpected(compact.GetNumDelegates(), 1);
+        compact(calls);
+        kExpected(calls, 22);
+
+        kCheckTrue(compact.RemoveById(lambdaId));
+        kExpected(compact.GetNumDelegates(), 0);
+        compact(calls);
+        kExpected(calls, 22);
+    }
+
+    // One function that removes itself and adds another one while running (it becomes a List)
+    {
+        Delegate<void(int &)> compact;
+        int    calls  = 0;
+        size_t selfId = 0;
+
+        selfId = compact.Add([&compact, &selfId](int &var) {
+            ++var;
+            kCheckTrue(compact.RemoveById(selfId));
+            kExpected(compact.GetNumDelegates(), 0);
+            compact.Add([](int &other) { other += 10; });
+            kExpected(compact.GetNumDelegates(), 1);
+        });
+        compact(calls);
+        kExpected(calls, 1);                                        // The new function is not called until the next time
+        kExpected(compact.GetNumDelegates(), 1);
+        compact(calls);
+        kExpected(calls, 11);
+    }
+
+    // Removing from a List while running (it goes back to one function)
+    {
+        Delegate<void(int &)> compact;
+        int    calls   = 0;
+        size_t otherId = 0;
+        bool   removed = false;
+
+        compact.Add([&compact, &otherId, &removed](int &var) {
+            ++var;
+            if (removed == false) {
+                removed = compact.RemoveById(otherId);
+                kExpected(compact.GetNumDelegates(), 1);
+            }
+        });
+        otherId = compact.Add([](int &var) { var += 10; });         // Disabled before being called
+        kExpected(compact.GetNumDelegates(), 2);
+        compact(calls);
+        kCheckTrue(removed);
+        kExpected(calls, 1);
+        kExpected(compact.GetNumDelegates(), 1);
+        compact(calls);
+        kExpected(calls, 2);
+    }
+
+    // Thread affinity (we call Dispatch from this thread to check it step by step)
+    {
+        DelegateExecutor    executor1, executor2;
+        Delegate<void(int)> affine;
+        int inlineSum = 0, sum1 = 0, sum2 = 0;
+
+        affine.Add([&inlineSum](int value) { inlineSum += value; });
+        auto id1 = affine.Add(executor1, [&sum1](int value) { sum1 += value; });
+        affine.Add(executor2, [&sum2](int value) { sum2 += 10 * value; });
+        affine.Add(executor1, [&sum1](int value) { sum1 += 100 * value; });
+        kExpected(affine.GetNumDelegates(), 4);
+
+        affine(1);
+        affine(2);
+        kExpected(inlineSum, 3);                                    // Without executor: called directly
+        kExpected(sum1, 0);                                         // With executor: waiting for Dispatch
+        kExpected(sum2, 0);
+        kExpected(executor1.Dispatch(), 2);                         // One message per call with both functions
+        kExpected(sum1, 303);
+        kExpected(sum2, 0);
+        kExpected(executor2.Dispatch(), 2);
+        kExpected(sum2, 30);
+        kCheckFalse(executor1.HasPending());
+        kCheckFalse(executor2.HasPending());
+
+        // Removing before Dispatch cancels the pending call
+        affine(1);
+        kCheckTrue(affine.RemoveById(id1));
+        kExpected(affine.GetNumDelegates(), 3);
+        kExpected(executor1.Dispatch(), 2);                         // The call and the Release of the removed function
+        kExpected(sum1, 403);
+        kExpected(executor2.Dispatch(), 1);
+        kExpected(sum2, 40);
+    }
+
+    // Destroying the delegate before Dispatch: its functions are released by the executor
+    {
+        DelegateExecutor executor;
+        {
+            Tracker             tracker;
+            Delegate<void()>    owner;
+            owner.Add(executor, [tracker]() {});
+            owner();
+        }
+        kExpected(Tracker::alive, 1);                               // The copy owned by the function
+        kExpected(executor.Dispatch(), 2);                          // The (cancelled) call and the Release
+        kExpected(Tracker::alive, 0);
+    }
+
+    // Messages are run in the same order they were posted
+    {
+        DelegateExecutor    executor;
+        std::vector<int>    order;
+
+        executor.Post(new OrderMessage(order, 1));
+        executor.Post(new OrderMessage(order, 2));
+        executor.Post(new OrderMessage(order, 3));
+        kExpected(executor.Dispatch(), 3);
+        kCheckTrue((order == std::vector<int> { 1, 2, 3 }));
+
+        Delegate<void(int)> ordered;
+        ordered.Add(executor, [&order](int value) { order.emplace_back(value); });
+        ordered(4);
+        ordered(5);
+        ordered(6);
+        kExpected(executor.Dispatch(), 3);
+        kCheckTrue((order == std::vector<int> { 1, 2, 3, 4, 5, 6 }));
+    }
+
     // rValues
     Delegate<void(std::string)> delegate2;
     delegate2.Add([](std::string str) { printf(" - lambda with parameters [str = %s]\n", str.c_str()); });
@@ -196,5 +519,88 @@ main(int argc, char *argv[]) {
     printf("Time Delegate:      %d\n", GetTime(time1));
     printf("Time std::function: %d\n", GetTime(time2));
 
+    // Memory: most delegates never get a function
+    constexpr const size_t numInstances = 10000000;
+    constexpr const size_t listenerStep = 100;
+    constexpr const size_t numSparse    = numInstances / listenerStep;
+
+    printf("\nMemory (%zu delegates):\n", numInstances);
+    printf("sizeof(Delegate<void()>):     %zu\n", sizeof(Delegate<void()>));
+    printf("sizeof(Delegate<void(int&)>): %zu\n", sizeof(Delegate<void(int &)>));
+    printf("sizeof(legacy layout):        %zu\n", sizeof(LegacyDelegateLayout));
+
+    HeapCounter idleHeap;
+    std::unique_ptr<Delegate<void(int &)>[]> delegates(new Delegate<void(int &)>[numInstances]);
+    size_t idleBytes       = idleHeap.GetBytes();
+    size_t idleAllocations = idleHeap.GetAllocations();
+
+    value = 0;
+    auto timeStamp3 = Now();
+    for (size_t i=0; i<numInstances; ++i)
+        delegates[i](value);
+    auto time3 = Now() - timeStamp3;
+    kExpected(value, 0);
+
+    // One function every 'listenerStep' delegates (one Wrapper allocation each, no List)
+    HeapCounter sparseHeap;
+    for (size_t i=0; i<numInstances; i+=listenerStep)
+        delegates[i].Add(inc);
+    size_t sparseBytes       = sparseHeap.GetBytes();
+    size_t sparseAllocations = sparseHeap.GetAllocations();
+    kExpected(sparseAllocations, numSparse);
+
+    auto timeStamp4 = Now();
+    for (size_t i=0; i<numInstances; ++i)
+        delegates[i](value);
+    auto time4 = Now() - timeStamp4;
+    kExpected(value, numInstances / listenerStep);
+
+    delegates.reset();
+
+    // The same with the legacy layout. It holds the same Wrappers, plus the buffer of its vector
+    size_t legacyIdleBytes, legacyIdleAllocations, legacySparseBytes, legacySparseAllocations;
+    {
+        HeapCounter legacyIdleHeap;
+        std::unique_ptr<LegacyDelegateLayout[]> legacy(new LegacyDelegateLayout[numInstances]);
+        legacyIdleBytes       = legacyIdleHeap.GetBytes();
+        legacyIdleAllocations = legacyIdleHeap.GetAllocations();
+
+        HeapCounter legacySparseHeap;
+        for (size_t i=0; i<numInstances; i+=listenerStep)
+            legacy[i].wrappers.emplace_back(nullptr);
+        legacySparseBytes       = legacySparseHeap.GetBytes() + sparseBytes;
+        legacySparseAllocations = legacySparseHeap.GetAllocations() + sparseAllocations;
+    }
+
+    printf("Heap idle:     %zu bytes in %zu allocations (legacy layout: %zu bytes in %zu allocations)\n",
+           idleBytes, idleAllocations, legacyIdleBytes, legacyIdleAllocations);
+    printf("Heap sparse:   %zu bytes in %zu allocations (legacy layout: %zu bytes in %zu allocations) for %zu functions\n",
+           sparseBytes, sparseAllocations, legacySparseBytes, legacySparseAllocations, numSparse);
+    printf("Time emit idle:         %d\n", GetTime(time3));
+    printf("Time emit sparse:       %d\n", GetTime(time4));
+
+    // Thread affinity
+    constexpr const size_t numListeners = 4;
+
+    printf("\nCross-thread delivery (%zu listeners):\n", numListeners);
+    {
+        DelegateExecutor        executor;
+        Receiver                receiver;
+        Delegate<void(int64_t)> delegate4;
+        for (size_t i=0; i<numListeners; ++i)
+            delegate4.Add(executor, [&receiver](int64_t sent) { receiver.Receive(sent); });
+
+        BenchmarkCrossThread("DelegateExecutor", delegate4, executor, receiver, numListeners);
+    }
+    {
+        FunctionQueue           queue;
+        Receiver                receiver;
+        Delegate<void(int64_t)> delegate4;
+        for (size_t i=0; i<numListeners; ++i)
+            delegate4.Add([&queue, &receiver](int64_t sent) { queue.Post([&receiver, sent]() { receiver.Receive(sent); }); });
+
+        BenchmarkCrossThread("mutex + std::function", delegate4, queue, receiver, numListeners);
+    }
+
     return 0;
 }
\ No newline at end of file
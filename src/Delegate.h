@@ -16,6 +16,9 @@
 #include <algorithm>
 #include <atomic>
 #include <functional>
+#include <tuple>
+#include <utility>
+#include <cstring>
 //--
 #include <cstdio>   // Replace fprintf by your logger
 
@@ -50,6 +53,12 @@ namespace MindShake {
     template <typename Class, typename Type>
     using EnableIfClass = typename std::enable_if<std::is_class<Class>::value, Type>::type;
 
+    template <bool ...>
+    struct BoolPack {};
+
+    template <bool ...Values>
+    using AllTrue = std::is_same<BoolPack<true, Values...>, BoolPack<Values..., true>>;
+
     //---------------------------------
     template <class Class>
     inline Method<Class>
@@ -66,6 +75,101 @@ namespace MindShake {
 
     //---------------------------------
 
+    //---------------------------------
+    // Mailbox of a thread. Functions added with Add(executor, ...) are not called by
+    // operator(): each call posts one message per executor (with a copy of the arguments)
+    // that is run when the owner thread calls Dispatch (ie. once per frame in its loop).
+    // Post is lock-free and can be called from any thread. Dispatch must only be called
+    // from one thread at a time.
+    // Removing a function cancels its calls that have not started yet, but it does not
+    // wait for a call that is already running in the executor thread.
+    // The executor must outlive the delegates that use it.
+    //---------------------------------
+    class DelegateExecutor {
+        public:
+            struct Message {
+                virtual         ~Message() = default;
+                virtual void    Run() = 0;
+
+                Message         *next {};
+            };
+
+        public:
+                                DelegateExecutor() = default;
+                                ~DelegateExecutor();
+
+                                DelegateExecutor(const DelegateExecutor &)            = delete;
+            DelegateExecutor &  operator = (const DelegateExecutor &)                 = delete;
+
+            void                Post(Message *message);
+
+            size_t              Dispatch();
+
+            bool                HasPending() const                                    { return mHead.load(std::memory_order_acquire) != nullptr; }
+
+        protected:
+            Message *           TakeAll();
+
+        protected:
+            std::atomic<Message *>  mHead {};
+    };
+
+    //---------------------------------
+    // DelegateExecutor
+    //---------------------------------
+    inline
+    DelegateExecutor::~DelegateExecutor() {
+        // Pending calls are discarded, but the pending wrappers are released
+        Message *message = TakeAll();
+        while (message != nullptr) {
+            Message *next = message->next;
+            delete message;
+            message = next;
+        }
+    }
+
+    //---------------------------------
+    inline void
+    DelegateExecutor::Post(Message *message) {
+        Message *head = mHead.load(std::memory_order_relaxed);
+        do {
+            message->next = head;
+        } while (mHead.compare_exchange_weak(head, message, std::memory_order_release, std::memory_order_relaxed) == false);
+    }
+
+    //---------------------------------
+    inline size_t
+    DelegateExecutor::Dispatch() {
+        size_t  count   = 0;
+        Message *message = TakeAll();
+        while (message != nullptr) {
+            Message *next = message->next;
+            message->Run();
+            delete message;
+            message = next;
+            ++count;
+        }
+
+        return count;
+    }
+
+    //---------------------------------
+    // Messages are pushed as a stack, so we reverse them to keep the posting order
+    //---------------------------------
+    inline DelegateExecutor::Message *
+    DelegateExecutor::TakeAll() {
+        Message *message = mHead.exchange(nullptr, std::memory_order_acquire);
+        Message *fifo    = nullptr;
+        while (message != nullptr) {
+            Message *next = message->next;
+            message->next = fifo;
+            fifo    = message;
+            message = next;
+        }
+
+        return fifo;
+    }
+
     //---------------------------------
     template <typename T>
     class Delegate;
@@ -86,6 +190,7 @@ namespace MindShake {
             struct Wrapper {
                                 Wrapper() = default;
                 explicit        Wrapper(TFunc f) : func(f) {}
+                explicit        Wrapper(size_t i) : id(i) {}                // Reuses an id (without increasing wrapperCounter)
                 virtual         ~Wrapper() { ToBeRemoved(); }
 
                 virtual void    operator()(const Args&... args) const {
@@ -93,9 +198,9 @@ namespace MindShake {
                     else if (func != nullptr)    (*func)(args...);
                 }
 
-                void            ToBeRemoved() { object = nullptr, func = {}, isEnabled = false; }
+                virtual void    ToBeRemoved() { object = nullptr, func = {}, isEnabled = false; }
 
-                enum class Type { Unknown, Function, Method, Lambda, StdFunction };
+                enum class Type { Unknown, Function, Method, Lambda, StdFunction, Thread };
 
                 //--
                 UnknownClass    *object {};
@@ -154,6 +259,88 @@ namespace MindShake {
                 std::function<void(Args...)> function;
             };
 
+            struct BatchBase;
+
+            // Function called from an executor (see Add(executor, ...)).
+            // It copies the data of the function it owns, so Find works as usual.
+            // newBatch is the only place where the arguments are copied, so delegates
+            // without executors do not require copyable arguments.
+            //-----------------------------
+            struct WrapperThread : Wrapper {
+                WrapperThread(Wrapper *f, DelegateExecutor *e) : Wrapper(f->id), function(f), executor(e), newBatch(&NewBatch) {
+                    Wrapper::type   = Wrapper::Type::Thread;
+                    Wrapper::object = f->object;
+                    memcpy(reinterpret_cast<void *>(&this->method), reinterpret_cast<const void *>(&f->method), sizeof(TMethod));
+                }
+                ~WrapperThread() override                                   { delete function;                                             }
+
+                void    operator()(const Args&... args) const override {
+                    if (isActive)
+                        (*function)(args...);
+                }
+
+                // The executor thread could be calling the function, so we do not touch it
+                void    ToBeRemoved() override                              { Wrapper::ToBeRemoved(); isActive = false;                    }
+
+                Wrapper             *function;
+                DelegateExecutor    *executor;
+                BatchBase *         (*newBatch)(DelegateExecutor *, const Args&...);
+                std::atomic_bool    isActive {true};
+            };
+
+            // All the functions of one executor for one call.
+            // The first ones are stored inline, so a batch usually costs one allocation.
+            //-----------------------------
+            struct BatchBase : DelegateExecutor::Message {
+                static constexpr size_t kNumInline = 4;
+
+                explicit BatchBase(DelegateExecutor *e) : executor(e) {}
+
+                void    Push(const WrapperThread *wrapper) {
+                    if (numWrappers < kNumInline)
+                        inlineWrappers[numWrappers] = wrapper;
+                    else
+                        moreWrappers.emplace_back(wrapper);
+                    ++numWrappers;
+                }
+
+                const WrapperThread *
+                        Get(size_t idx) const                               { return idx < kNumInline ? inlineWrappers[idx] : moreWrappers[idx - kNumInline]; }
+
+                DelegateExecutor                    *executor;
+                size_t                              numWrappers {};
+                const WrapperThread                 *inlineWrappers[kNumInline];
+                std::vector<const WrapperThread *>  moreWrappers;
+            };
+
+            // With a copy of the arguments
+            //-----------------------------
+            struct Batch : BatchBase {
+                explicit Batch(DelegateExecutor *e, const Args&... a) : BatchBase(e), args(a...) {}
+
+                void    Run() override                                      { Run(std::index_sequence_for<Args...>());                     }
+
+                template <size_t ...I>
+                void    Run(std::index_sequence<I...>) {
+                    for (size_t i = 0; i < BatchBase::numWrappers; ++i) {
+                        Invoke(*BatchBase::Get(i), [this](const Wrapper &w) { w(std::get<I>(args)...); });
+                    }
+                }
+
+                std::tuple<typename std::decay<Args>::type...>  args;
+            };
+
+            // Deletes the wrapper in the executor thread after its pending calls
+            //-----------------------------
+            struct Release : DelegateExecutor::Message {
+                explicit Release(Wrapper *w) : wrapper(w) {}
+                        ~Release() override                                 { delete wrapper;                                              }
+
+                void    Run() override                                      {                                                              }
+
+                Wrapper *wrapper;
+            };
+
         // Some helpers
         protected:
             template <class Class>
@@ -166,7 +353,10 @@ namespace MindShake {
 
         public:
                                 Delegate() = default;
-            virtual             ~Delegate()                                           { Clear();                                                     }
+                                ~Delegate()                                           { Clear();                                                     }
+
+                                Delegate(const Delegate &)                = delete;
+            Delegate &          operator = (const Delegate &)             = delete;
 
             //-------------------------
             // Add
@@ -191,17 +381,13 @@ namespace MindShake {
 
             // Hack to detect lambdas with captures
             template <typename Lambda, typename std::enable_if<!std::is_assignable<Lambda, Lambda>::value, bool>::type = true>
-            size_t              Add(const Lambda &lambda) {
-                auto wrapper = new WrapperLambda<Lambda>(lambda);
-                mWrappers.emplace_back(wrapper);
-                return wrapper->id;
-            }
+            size_t              Add(const Lambda &lambda)                             { return AddWrapper(new WrapperLambda<Lambda>(lambda));        }
 
-            size_t Add(const std::function<void(Args...)> &func) {
-                auto wrapper = new WrapperStdFunction(func);
-                mWrappers.emplace_back(wrapper);
-                return wrapper->id;
-            }
+            size_t              Add(const std::function<void(Args...)> &func)         { return AddWrapper(new WrapperStdFunction(func));             }
+
+            // Thread affinity: the function will be called from executor.Dispatch()
+            template <typename ...Params>
+            size_t              Add(DelegateExecutor &executor, Params&&... params);
 
             //-------------------------
             // Remove
@@ -248,7 +434,7 @@ namespace MindShake {
             //-------------------------
             // Other
             //-------------------------
-            size_t              GetNumDelegates() const                               { return mWrappers.size() - mToRemove.size();                  }
+            size_t              GetNumDelegates() const;
 
             void                Clear();
 
@@ -279,14 +465,61 @@ namespace MindShake {
             //}
 
         protected:
+            // Storage used only when there is more than one function
+            //-------------------------
+            struct List {
+                std::vector<Wrapper *>  wrappers;
+                std::vector<size_t>     toRemove;
+                std::atomic_bool        isRunning {};
+            };
+
+            // mState encodes the storage in a single word:
+            //  - 0:                     no functions (emitting is a single null check)
+            //  - Wrapper *:             just one function, no List allocated
+            //  - Wrapper * | kRunning:  just one function, being executed
+            //  - List *    | kList:     more than one function
+            //-------------------------
+            static constexpr uintptr_t kList    = 1;
+            static constexpr uintptr_t kRunning = 2;
+            static constexpr uintptr_t kTagMask = kList | kRunning;
+
+            bool            IsList() const                                      { return (mState & kList) != 0;                                }
+            List *          GetList() const                                     { return reinterpret_cast<List *>(mState & ~kTagMask);         }
+            Wrapper *       GetSingle() const                                   { return reinterpret_cast<Wrapper *>(mState & ~kTagMask);      }
+
+            size_t          GetNumWrappers() const                              { return IsList() ? GetList()->wrappers.size() : (mState != 0); }
+            Wrapper *       GetWrapper(size_t idx) const                        { return IsList() ? GetList()->wrappers[idx] : GetSingle();    }
+
+            size_t          AddWrapper(Wrapper *wrapper);
+
             bool            RemoveIndex(ptrdiff_t idx);
 
-            void            RemoveLazyDeleted();
+            void            RemoveLazyDeleted(List *list);
+
+            void            Shrink();
+
+            static void     DeleteWrapper(Wrapper *wrapper);
+
+            // Arguments are copied to be sent to an executor (and references to polymorphic classes would be sliced)
+            template <typename Arg>
+            using IsQueueable = std::integral_constant<bool, std::is_copy_constructible<typename std::decay<Arg>::type>::value &&
+                                                             !(std::is_reference<Arg>::value && std::is_polymorphic<typename std::decay<Arg>::type>::value)>;
+
+            static BatchBase *
+                            NewBatch(DelegateExecutor *executor, const Args&... args);
+
+            static void     Enqueue(BatchBase *&batches, const WrapperThread *wrapper, const Args&... args);
+
+            static void     PostAll(BatchBase *batches);
+
+            template <typename Call>
+            void            Emit(const Call &call, const Args&... args);
+
+            template <typename Call>
+            static void     Invoke(const Wrapper &wrapper, const Call &call);
 
         protected:
-            std::vector<Wrapper *>  mWrappers;
-            std::vector<size_t>     mToRemove;
-            std::atomic_bool        mIsRunning {};
+            std::atomic<uintptr_t>  mState {};
     };
 
     //---------------------------------
@@ -302,9 +535,7 @@ namespace MindShake {
     inline size_t
     Delegate<void(Args...)>::Add(TFunc func) {
         if (func != nullptr) {
-            auto wrapper = new WrapperCFunc(func);
-            mWrappers.emplace_back(wrapper);
-            return wrapper->id;
+            return AddWrapper(new WrapperCFunc(func));
         }
 
         return size_t(-1);
@@ -329,7 +560,60 @@ namespace MindShake {
         wrapper->method = reinterpret_cast<TMethod>(method);
     #endif
 
-        mWrappers.emplace_back(wrapper);
+        return AddWrapper(wrapper);
+    }
+
+    //---------------------------------
+    template <typename ...Args>
+    template <typename ...Params>
+    inline size_t
+    Delegate<void(Args...)>::Add(DelegateExecutor &executor, Params&&... params) {
+        static_assert(AllTrue<IsQueueable<Args>::value...>::value,
+                      "Functions with an executor receive a copy of the arguments: they must be copyable and not references to polymorphic classes");
+
+        // Reuse all the Add overloads to build the wrapper, and take it before publishing it
+        Delegate    function;
+        if (function.Add(std::forward<Params>(params)...) == size_t(-1))
+            return size_t(-1);
+
+        Wrapper *wrapper = function.GetSingle();
+        function.mState  = 0;
+
+        return AddWrapper(new WrapperThread(wrapper, &executor));
+    }
+
+    //---------------------------------
+    // The pointer to the first Wrapper is stored directly in mState.
+    // The List is only allocated when a second one is added.
+    //---------------------------------
+    template <typename ...Args>
+    inline size_t
+    Delegate<void(Args...)>::AddWrapper(Wrapper *wrapper) {
+        static_assert(alignof(Wrapper) > kTagMask, "Wrapper alignment is too small to tag its pointer");
+        static_assert(alignof(List)    > kTagMask, "List alignment is too small to tag its pointer");
+
+        if (mState == 0) {
+            mState = reinterpret_cast<uintptr_t>(wrapper);
+        }
+        else if (IsList()) {
+            GetList()->wrappers.emplace_back(wrapper);
+        }
+        else {
+            Wrapper *single = GetSingle();
+            List    *list   = new List;
+
+            list->wrappers.reserve(2);
+            list->wrappers.emplace_back(single);
+            list->wrappers.emplace_back(wrapper);
+            // We are being executed: the List takes care of the lazy deletion from now on
+            if ((mState & kRunning) != 0) {
+                list->isRunning = true;
+                if (single->isEnabled == false) {
+                    list->toRemove.emplace_back(0);
+                }
+            }
+            mState = reinterpret_cast<uintptr_t>(list) | kList;
+        }
 
         return wrapper->id;
     }
@@ -340,8 +624,11 @@ namespace MindShake {
     template <typename ...Args>
     inline bool
     Delegate<void(Args...)>::RemoveById(size_t id) {
-        for (size_t i=0; i<mWrappers.size(); ++i) {
-            if (mWrappers[i]->id == id) {
+        size_t  size = GetNumWrappers();
+
+        for (size_t i=0; i<size; ++i) {
+            const Wrapper *wrapper = GetWrapper(i);
+            if (wrapper->isEnabled && wrapper->id == id) {
                 return RemoveIndex(i);
             }
         }
@@ -354,13 +641,28 @@ namespace MindShake {
     inline bool
     Delegate<void(Args...)>::RemoveIndex(ptrdiff_t idx) {
         if (idx >= 0) {
-            if (mIsRunning == false) {
-                delete mWrappers[idx];
-                mWrappers.erase(mWrappers.begin() + idx);
+            if (IsList()) {
+                List    *list = GetList();
+
+                if (list->isRunning == false) {
+                    DeleteWrapper(list->wrappers[idx]);
+                    list->wrappers.erase(list->wrappers.begin() + idx);
+                    Shrink();
+                }
+                else {
+                    list->wrappers[idx]->ToBeRemoved();
+                    list->toRemove.emplace_back(idx);
+                }
             }
             else {
-                mWrappers[idx]->ToBeRemoved();
-                mToRemove.emplace_back(idx);
+                if ((mState & kRunning) == 0) {
+                    DeleteWrapper(GetSingle());
+                    mState = 0;
+                }
+                else {
+                    // Deleted by Emit when the call finishes
+                    GetSingle()->ToBeRemoved();
+                }
             }
 
             return true;
@@ -372,17 +674,32 @@ namespace MindShake {
     //---------------------------------
     template <typename ...Args>
     inline void
-    Delegate<void(Args...)>::RemoveLazyDeleted() {
+    Delegate<void(Args...)>::RemoveLazyDeleted(List *list) {
         ptrdiff_t   i, size;
 
-        std::sort(mToRemove.begin(), mToRemove.end());
-        size = mToRemove.size() - 1;
+        std::sort(list->toRemove.begin(), list->toRemove.end());
+        size = list->toRemove.size() - 1;
         for (i=size; i>=0; --i) {
-            delete mWrappers[mToRemove[i]];
-            mWrappers.erase(mWrappers.begin() + mToRemove[i]);
+            DeleteWrapper(list->wrappers[list->toRemove[i]]);
+            list->wrappers.erase(list->wrappers.begin() + list->toRemove[i]);
         }
 
-        mToRemove.clear();
+        list->toRemove.clear();
+    }
+
+    //---------------------------------
+    // Go back to the compact representation when possible
+    //---------------------------------
+    template <typename ...Args>
+    inline void
+    Delegate<void(Args...)>::Shrink() {
+        List    *list = GetList();
+
+        if (list->wrappers.size() > 1)
+            return;
+
+        mState = list->wrappers.empty() ? 0 : reinterpret_cast<uintptr_t>(list->wrappers[0]);
+        delete list;
     }
 
     //---------------------------------
@@ -393,49 +710,151 @@ namespace MindShake {
     //---------------------------------
     template <typename ...Args>
     template <typename Dummy>
-    typename std::enable_if<sizeof...(Args) != 0, Dummy>::type
+    inline typename std::enable_if<sizeof...(Args) != 0, Dummy>::type
     Delegate<void(Args...)>::operator()(Args&&... args) {
-        if (mIsRunning.exchange(true) == false) {
-            // In this way we allow adding functions but not deleting them
-            size_t size = mWrappers.size();
-            for (size_t i = 0; i < size; ++i) {
-                auto &wrapper = *mWrappers[i];
-                try {
-                    wrapper(std::forward<Args>(args)...);
-                }
-                catch (const std::exception &e) {
-                    fprintf(stderr, "Exception calling user function %ud: %s", unsigned(wrapper.id), e.what());
-                }
-                catch (...) {
-                    fprintf(stderr, "Unknown exception calling user function");
-                }
-            }
-            RemoveLazyDeleted();
-            mIsRunning = false;
+        if (mState != 0) {
+            Emit([&](const Wrapper &wrapper) { wrapper(std::forward<Args>(args)...); }, args...);
         }
     }
 
     //---------------------------------
     template <typename ...Args>
-    void
+    inline void
     Delegate<void(Args...)>::operator()(const Args&... args) {
-        if (mIsRunning.exchange(true) == false) {
+        if (mState != 0) {
+            Emit([&](const Wrapper &wrapper) { wrapper(args...); }, args...);
+        }
+    }
+
+    //---------------------------------
+    template <typename ...Args>
+    template <typename Call>
+    void
+    Delegate<void(Args...)>::Emit(const Call &call, const Args&... args) {
+        BatchBase   *batches = nullptr;
+
+        uintptr_t   state = mState;
+
+        if ((state & kList) == 0) {
+            if ((state & kRunning) != 0)
+                return;
+
+            Wrapper *wrapper = reinterpret_cast<Wrapper *>(state);
+
+            if (wrapper->type == Wrapper::Type::Thread) {
+                Enqueue(batches, static_cast<const WrapperThread *>(wrapper), args...);
+                PostAll(batches);
+                return;
+            }
+
+            // As List::isRunning: if someone else is running it, we skip the call
+            if (mState.compare_exchange_strong(state, state | kRunning) == false)
+                return;
+
+            Invoke(*wrapper, call);
+
+            // A function was added while running, so we have been promoted to a List
+            if (IsList()) {
+                List    *list = GetList();
+
+                RemoveLazyDeleted(list);
+                list->isRunning = false;
+                Shrink();
+            }
+            else if (mState != 0) {
+                mState &= ~kRunning;
+                if (GetSingle()->isEnabled == false) {
+                    DeleteWrapper(GetSingle());
+                    mState = 0;
+                }
+            }
+            return;
+        }
+
+        List    *list = GetList();
+
+        if (list->isRunning.exchange(true) == false) {
             // In this way we allow adding functions but not deleting them
-            size_t size = mWrappers.size();
+            size_t size = list->wrappers.size();
             for (size_t i = 0; i < size; ++i) {
-                auto &wrapper = *mWrappers[i];
-                try {
-                    wrapper(args...);
-                }
-                catch (const std::exception &e) {
-                    fprintf(stderr, "Exception calling user function %ud: %s", unsigned(wrapper.id), e.what());
-                }
-                catch (...) {
-                    fprintf(stderr, "Unknown exception calling user function");
-                }
+                const Wrapper *wrapper = list->wrappers[i];
+                if (wrapper->type != Wrapper::Type::Thread)
+                    Invoke(*wrapper, call);
+                else if (wrapper->isEnabled)
+                    Enqueue(batches, static_cast<const WrapperThread *>(wrapper), args...);
             }
-            RemoveLazyDeleted();
-            mIsRunning = false;
+            // Before removing, so the Release messages arrive after these calls
+            PostAll(batches);
+            RemoveLazyDeleted(list);
+            list->isRunning = false;
+            Shrink();
+        }
+    }
+
+    //---------------------------------
+    template <typename ...Args>
+    template <typename Call>
+    inline void
+    Delegate<void(Args...)>::Invoke(const Wrapper &wrapper, const Call &call) {
+        try {
+            call(wrapper);
+        }
+        catch (const std::exception &e) {
+            fprintf(stderr, "Exception calling user function %ud: %s", unsigned(wrapper.id), e.what());
+        }
+        catch (...) {
+            fprintf(stderr, "Unknown exception calling user function");
+        }
+    }
+
+    //---------------------------------
+    template <typename ...Args>
+    inline void
+    Delegate<void(Args...)>::DeleteWrapper(Wrapper *wrapper) {
+        if (wrapper->type != Wrapper::Type::Thread) {
+            delete wrapper;
+        }
+        else {
+            wrapper->ToBeRemoved();
+            static_cast<WrapperThread *>(wrapper)->executor->Post(new Release(wrapper));
+        }
+    }
+
+    //---------------------------------
+    template <typename ...Args>
+    inline typename Delegate<void(Args...)>::BatchBase *
+    Delegate<void(Args...)>::NewBatch(DelegateExecutor *executor, const Args&... args) {
+        return new Batch(executor, args...);
+    }
+
+    //---------------------------------
+    // Batches are kept in a list (using Message::next) until they are posted
+    //---------------------------------
+    template <typename ...Args>
+    inline void
+    Delegate<void(Args...)>::Enqueue(BatchBase *&batches, const WrapperThread *wrapper, const Args&... args) {
+        BatchBase *batch = batches;
+        while (batch != nullptr && batch->executor != wrapper->executor) {
+            batch = static_cast<BatchBase *>(batch->next);
+        }
+
+        if (batch == nullptr) {
+            batch       = wrapper->newBatch(wrapper->executor, args...);
+            batch->next = batches;
+            batches     = batch;
+        }
+
+        batch->Push(wrapper);
+    }
+
+    //---------------------------------
+    template <typename ...Args>
+    inline void
+    Delegate<void(Args...)>::PostAll(BatchBase *batches) {
+        while (batches != nullptr) {
+            BatchBase *next = static_cast<BatchBase *>(batches->next);
+            batches->executor->Post(batches);
+            batches = next;
         }
     }
 
@@ -445,13 +864,13 @@ namespace MindShake {
     template <typename ...Args>
     inline ptrdiff_t
     Delegate<void(Args...)>::Find(const TFunc func) const {
-        ptrdiff_t   i = 0;
+        size_t  size = GetNumWrappers();
 
-        for (const auto *wrapper : mWrappers) {
-            if (wrapper->func == func) {
+        for (size_t i=0; i<size; ++i) {
+            const Wrapper *wrapper = GetWrapper(i);
+            if (wrapper->isEnabled && wrapper->func == func) {
                 return i;
             }
-            ++i;
         }
 
         return -1;
@@ -462,10 +881,11 @@ namespace MindShake {
     template <typename Class>
     inline typename std::enable_if<std::is_class<Class>::value, ptrdiff_t>::type
     Delegate<void(Args...)>::Find(Class *object, void(Class::*method)(Args...)) const {
-        ptrdiff_t   i = 0;
+        size_t  size = GetNumWrappers();
 
-        for (const auto *wrapper : mWrappers) {
-            if (wrapper->object == reinterpret_cast<UnknownClass *>(object)) {
+        for (size_t i=0; i<size; ++i) {
+            const Wrapper *wrapper = GetWrapper(i);
+            if (wrapper->isEnabled && wrapper->object == reinterpret_cast<UnknownClass *>(object)) {
     #if defined(_MSC_VER)
                 if (memcmp(&wrapper->method, reinterpret_cast<void *>(&method), sizeof(method)) == 0) {
     #else
@@ -474,22 +894,42 @@ namespace MindShake {
                     return i;
                 }
             }
-            ++i;
         }
 
         return -1;
     }
 
+    //---------------------------------
+    // Other
+    //---------------------------------
+    template <typename ...Args>
+    inline size_t
+    Delegate<void(Args...)>::GetNumDelegates() const {
+        if (IsList()) {
+            const List *list = GetList();
+            return list->wrappers.size() - list->toRemove.size();
+        }
+
+        return (mState != 0 && GetSingle()->isEnabled) ? 1 : 0;
+    }
+
     //---------------------------------
     template <typename ...Args>
     inline void
     Delegate<void(Args...)>::Clear() {
-        for (auto *w : mWrappers) {
-            delete w;
+        if (IsList()) {
+            List    *list = GetList();
+
+            for (auto *w : list->wrappers) {
+                DeleteWrapper(w);
+            }
+            delete list;
+        }
+        else if (mState != 0) {
+            DeleteWrapper(GetSingle());
         }
 
-        mWrappers.clear();
-        mToRemove.clear();
+        mState = 0;
     }
 
 } // end of namespace